@@ -0,0 +1,217 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <cstdlib>
+#include "sorting.h"
+
+using namespace std;
+
+// Training and evaluation workload for the profile-guided builds (see Makefile).
+// It exercises every kernel on production-like shapes so the profile sees the
+// real branch biases: dense and sparse key ranges, duplicate-heavy and skewed
+// keys, request-path batches of a few dozen records, wide and 8/16-bit key
+// records, float and double scores, 128-bit UUID keys, bucket classification,
+// and the key profile behind sortAuto.
+
+mt19937 gen;
+
+vector<Record> uniformKeys(int n, int k) {
+    vector<Record> data(n);
+    uniform_int_distribution<> distrib(0, k);
+    for (int i = 0; i < n; i++) data[i] = {distrib(gen), i};
+    return data;
+}
+
+// Many keys near 0, few large ones (same shape as SKEWED in main.cpp)
+vector<Record> skewedKeys(int n, int k) {
+    vector<Record> data(n);
+    uniform_real_distribution<> dis(0, 1);
+    for (int i = 0; i < n; i++) {
+        double r = dis(gen);
+        data[i] = {(int)(r * r * k), i};
+    }
+    return data;
+}
+
+template <typename R>
+vector<R> widen(const vector<Record>& data) {
+    vector<R> out(data.size());
+    for (size_t i = 0; i < data.size(); i++) {
+        out[i].key = data[i].key;
+        out[i].id = data[i].id;
+    }
+    return out;
+}
+
+// Normalized scores in [0, 1), uniform or squared toward 0
+template <typename R>
+vector<R> unitScores(int n, bool skewed) {
+    vector<R> data(n);
+    uniform_real_distribution<> dis(0, 1);
+    for (int i = 0; i < n; i++) {
+        double r = dis(gen);
+        data[i] = {(decltype(R::key))(skewed ? r * r : r), i};
+    }
+    return data;
+}
+
+#ifdef __SIZEOF_INT128__
+// Random UUIDs, or time-ordered ones whose high bytes barely vary (UUIDv7-like)
+vector<Record128> uuidKeys(int n, bool timeOrdered) {
+    vector<Record128> data(n);
+    uniform_int_distribution<uint64_t> distrib;
+    uint64_t clock = 1700000000000ull << 16;
+    for (int i = 0; i < n; i++) {
+        uint64_t hi = timeOrdered ? (clock += distrib(gen) % 64) : distrib(gen);
+        data[i] = {makeKey128(hi, distrib(gen)), i};
+    }
+    return data;
+}
+#endif
+
+struct Workload {
+    string name;
+    function<void()> run;
+};
+
+// Sorts a fresh copy of `data` with `sortFunc`
+template <typename R>
+function<void()> sortCopy(void (*sortFunc)(vector<R>&), vector<R> data) {
+    return [sortFunc, data]() {
+        vector<R> copy = data;
+        sortFunc(copy);
+    };
+}
+
+// Many small request-path sorts through one kernel
+function<void()> smallBatches(void (*sortFunc)(vector<Record>&), int n, int batches) {
+    vector<vector<Record>> pool;
+    for (int i = 0; i < 32; i++) pool.push_back(uniformKeys(n, 4 * n));
+    return [sortFunc, pool, batches]() {
+        for (int b = 0; b < batches; b++) {
+            vector<Record> copy = pool[b % pool.size()];
+            sortFunc(copy);
+        }
+    };
+}
+
+vector<Workload> buildWorkloads() {
+    int hw = max(1u, thread::hardware_concurrency());
+    vector<Workload> w;
+
+    w.push_back({"counting_dense_1M", sortCopy(countingSortStable<Record>, uniformKeys(1000000, 1000000))});
+    w.push_back({"counting_dups_1M", sortCopy(countingSortStable<Record>, uniformKeys(1000000, 255))});
+    w.push_back({"radix_wide_range_1M", sortCopy(radixSortLSD<Record>, uniformKeys(1000000, 1000000000))});
+    w.push_back({"radix_skewed_1M", sortCopy(radixSortLSD<Record>, skewedKeys(1000000, 1000000))});
+    w.push_back({"bucket_uniform_200k", sortCopy(bucketSort<Record>, uniformKeys(200000, 200000))});
+    w.push_back({"bucket_skewed_200k", sortCopy(bucketSort<Record>, skewedKeys(200000, 200000))});
+    w.push_back({"pigeonhole_dense_200k", sortCopy(pigeonholeSort<Record>, uniformKeys(200000, 200000))});
+    w.push_back({"small_counting_64", smallBatches(countingSortStable<Record>, 64, 20000)});
+    w.push_back({"small_radix_64", smallBatches(radixSortLSD<Record>, 64, 20000)});
+    w.push_back({"small_bucket_256", smallBatches(bucketSort<Record>, 256, 2000)});
+    w.push_back({"wide64_counting_200k",
+                 sortCopy(countingSortStable<PaddedRecord<64>>, widen<PaddedRecord<64>>(uniformKeys(200000, 200000)))});
+    w.push_back({"wide128_indirect_200k",
+                 sortCopy(countingSortIndirect<PaddedRecord<128>>, widen<PaddedRecord<128>>(uniformKeys(200000, 200000)))});
+    w.push_back({"narrow8_counting_1M", sortCopy(countingSortStable<Record8>, widen<Record8>(uniformKeys(1000000, 255)))});
+    w.push_back({"narrow16_counting_200k",
+                 sortCopy(countingSortStable<Record16>, widen<Record16>(uniformKeys(200000, 65535)))});
+    w.push_back({"narrow16_radix_200k", sortCopy(radixSortLSD<Record16>, widen<Record16>(uniformKeys(200000, 65535)))});
+    w.push_back({"spread_wide_range_1M", sortCopy(spreadSort<Record>, uniformKeys(1000000, 1000000000))});
+    w.push_back({"spread_skewed_1M", sortCopy(spreadSort<Record>, skewedKeys(1000000, 1000000))});
+    w.push_back({"small_spread_64", smallBatches(spreadSort<Record>, 64, 20000)});
+    w.push_back({"unit_float_uniform_1M", sortCopy(bucketSortUnit<FloatRecord>, unitScores<FloatRecord>(1000000, false))});
+    w.push_back({"unit_float_skewed_1M", sortCopy(bucketSortUnit<FloatRecord>, unitScores<FloatRecord>(1000000, true))});
+    w.push_back({"unit_double_uniform_1M",
+                 sortCopy(bucketSortUnit<DoubleRecord>, unitScores<DoubleRecord>(1000000, false))});
+#ifdef __SIZEOF_INT128__
+    w.push_back({"key128_random_500k", sortCopy(radixSort128, uuidKeys(500000, false))});
+    w.push_back({"key128_time_ordered_500k", sortCopy(radixSort128, uuidKeys(500000, true))});
+#endif
+
+    // Bucket-id classification in each mode, including a padded splitter tree
+    uniform_int_distribution<> keyDistrib(0, 1 << 30);
+    vector<int> classifyInput(1000000), splitters(255);
+    for (int& key : classifyInput) key = keyDistrib(gen);
+    for (int& s : splitters) s = keyDistrib(gen);
+    sort(splitters.begin(), splitters.end());
+    vector<Classifier> classifiers = {linearClassifier(0, 1 << 30, 1000000), shiftClassifier(0, 1 << 30, 18),
+                                      splitterClassifier(splitters),
+                                      splitterClassifier(vector<int>(splitters.begin(), splitters.begin() + 5))};
+    w.push_back({"classify_modes_1M", [classifyInput, classifiers]() {
+        vector<uint32_t> ids(classifyInput.size());
+        for (const auto& c : classifiers) classifyKeys(c, classifyInput.data(), classifyInput.size(), ids.data());
+    }});
+
+    // One input per kernel sortAuto can choose, so the profile sees every branch of the choice
+    auto presorted = uniformKeys(1000000, 1000000000);
+    sort(presorted.begin(), presorted.end(), [](const Record& a, const Record& b) { return a.key < b.key; });
+    vector<Record> reversed(1000000);
+    for (int i = 0; i < (int)reversed.size(); i++) reversed[i] = {(int)reversed.size() - i, i};
+    vector<vector<Record>> autoInputs = {uniformKeys(1000000, 1000000), skewedKeys(1000000, 1000000),
+                                         uniformKeys(1000000, 1000000000), presorted, reversed};
+    for (int i = 0; i < 32; i++) autoInputs.push_back(uniformKeys(100, 1000000000));
+    w.push_back({"profile_keys_mixed", [autoInputs]() {
+        for (const auto& data : autoInputs) profileKeys(data);
+    }});
+    w.push_back({"sort_auto_mixed", [autoInputs]() {
+        for (const auto& data : autoInputs) {
+            vector<Record> copy = data;
+            sortAuto(copy);
+        }
+    }});
+
+    auto parallelInput = uniformKeys(2000000, 2000000);
+    w.push_back({"parallel_counting_2M", [parallelInput, hw]() {
+        vector<Record> copy = parallelInput;
+        countingSortParallel(copy, hw);
+    }});
+    w.push_back({"parallel_radix_2M", [parallelInput, hw]() {
+        vector<Record> copy = parallelInput;
+        radixSortParallel(copy, hw);
+    }});
+    w.push_back({"hybrid_radix_2M", [parallelInput]() {
+        vector<Record> copy = parallelInput;
+        radixSortHybrid(copy);
+    }});
+    w.push_back({"parallel_hybrid_radix_2M", [parallelInput, hw]() {
+        vector<Record> copy = parallelInput;
+        radixSortHybrid(copy, hw);
+    }});
+    return w;
+}
+
+int main(int argc, char** argv) {
+    unsigned seed = 12345;
+    int reps = 3;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) seed = atoi(argv[++i]);
+        else if (arg == "--reps" && i + 1 < argc) reps = max(1, atoi(argv[++i]));
+        else {
+            cout << "Usage: " << argv[0] << " [--seed N] [--reps N]\n";
+            return (arg == "--help" || arg == "-h") ? 0 : 2;
+        }
+    }
+    gen.seed(seed);
+
+    // One CSV row per workload with its median time, so builds can be compared
+    cout << "Workload,Median_ms\n";
+    for (const auto& w : buildWorkloads()) {
+        vector<double> times;
+        for (int rep = 0; rep < reps; rep++) {
+            auto start = chrono::high_resolution_clock::now();
+            w.run();
+            auto end = chrono::high_resolution_clock::now();
+            times.push_back(chrono::duration<double, milli>(end - start).count());
+        }
+        sort(times.begin(), times.end());
+        cout << w.name << "," << times[times.size() / 2] << endl;
+    }
+    return 0;
+}
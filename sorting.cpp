@@ -2,10 +2,121 @@
 #include <vector>
 #include <algorithm>
 #include <cmath>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <fstream>
+#include <type_traits>
+#include <climits>
+#include <cstring>
+#include <cstddef>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// --- Phase tracing ---
+struct TraceEvent {
+    const char* name;
+    const char* kernel;
+    double beginUs;
+    double durUs;
+    int tid;
+};
+
+static std::atomic<bool> tracingEnabled(false);
+static std::mutex traceMutex;
+static std::vector<TraceEvent> traceEvents;
+static const auto traceEpoch = std::chrono::steady_clock::now();
+
+static double traceNowUs() {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - traceEpoch).count();
+}
+
+// Small stable ids read better in the trace viewer than native thread ids
+static int traceThreadId() {
+    static std::atomic<int> nextId(0);
+    thread_local int id = nextId++;
+    return id;
+}
+
+void setSortTracing(bool enabled) {
+    tracingEnabled = enabled;
+}
+
+void clearSortTrace() {
+    std::lock_guard<std::mutex> lock(traceMutex);
+    traceEvents.clear();
+}
+
+bool writeSortTrace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) return false;
+    std::lock_guard<std::mutex> lock(traceMutex);
+
+    out << "{\"traceEvents\": [\n";
+    int maxTid = -1;
+    for (size_t i = 0; i < traceEvents.size(); i++) {
+        const TraceEvent& e = traceEvents[i];
+        maxTid = std::max(maxTid, e.tid);
+        out << "  {\"name\": \"" << e.name << "\", \"cat\": \"" << e.kernel
+            << "\", \"ph\": \"X\", \"ts\": " << std::fixed << e.beginUs << ", \"dur\": " << e.durUs
+            << ", \"pid\": 1, \"tid\": " << e.tid << ", \"args\": {\"kernel\": \"" << e.kernel << "\"}},\n";
+    }
+    for (int t = 0; t <= maxTid; t++) {
+        out << "  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << t
+            << ", \"args\": {\"name\": \"sort worker " << t << "\"}},\n";
+    }
+    out << "  {\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"sorting\"}}\n";
+    out << "]}\n";
+    return (bool)out;
+}
+
+// Records [construction or last next(), destruction or next()) as one phase.
+// Costs a single relaxed load per phase while tracing is off.
+class TraceScope {
+public:
+    TraceScope(const char* kernel, const char* name) : kernel(kernel), name(name) {
+        active = tracingEnabled.load(std::memory_order_relaxed);
+        if (active) begin = traceNowUs();
+    }
+    ~TraceScope() { end(); }
+
+    void next(const char* nextName) {
+        end();
+        name = nextName;
+        active = tracingEnabled.load(std::memory_order_relaxed);
+        if (active) begin = traceNowUs();
+    }
+
+    void end() {
+        if (!active) return;
+        active = false;
+        TraceEvent e = {name, kernel, begin, traceNowUs() - begin, traceThreadId()};
+        std::lock_guard<std::mutex> lock(traceMutex);
+        traceEvents.push_back(e);
+    }
+
+private:
+    const char* kernel;
+    const char* name;
+    double begin = 0;
+    bool active = false;
+};
 
 // Helper to find min and max for range calculation
-void getMinMax(const std::vector<Record>& arr, int& minVal, int& maxVal) {
+template <typename R>
+void getMinMax(const std::vector<R>& arr, int& minVal, int& maxVal) {
     if (arr.empty()) return;
+    TraceScope phase("getMinMax", "getMinMax");
     minVal = arr[0].key;
     maxVal = arr[0].key;
     for (const auto& rec : arr) {
@@ -14,46 +125,409 @@ void getMinMax(const std::vector<Record>& arr, int& minVal, int& maxVal) {
     }
 }
 
+// Stable insertion sort for small buckets and bins (stable_sort would allocate per call)
+template <typename R>
+static void insertionSortRecords(R* a, size_t n) {
+    for (size_t i = 1; i < n; i++) {
+        R item = a[i];
+        size_t j = i;
+        while (j > 0 && a[j - 1].key > item.key) {
+            a[j] = a[j - 1];
+            j--;
+        }
+        a[j] = item;
+    }
+}
+
+// --- Run-length aware scatter ---
+static bool runScatter = true;
+
+void setRunScatter(bool enabled) {
+    runScatter = enabled;
+}
+
+// Right-to-left stable scatter that moves every run of consecutive records with
+// the same bucket as one block: one counter update and one copy per run instead
+// of one dependent update per record. `end` holds each bucket's end position, as
+// left by the inclusive prefix sum. `bucketOf(i)` gives record i's bucket and
+// must be cheap, since the run test evaluates it once more per record. The run
+// test is a data-dependent branch: with many buckets it almost never fires and
+// predicts well, but with few (radix digits) callers should check repeats first.
+template <typename R, typename Count, typename BucketFn>
+static void scatterRuns(const std::vector<R>& in, std::vector<R>& out, Count* end, BucketFn bucketOf) {
+    long long i = (long long)in.size() - 1;
+    int bucket = bucketOf(i);
+    while (i >= 0) {
+        long long j = i;
+        int prev = bucket;
+        while (j > 0 && (prev = bucketOf(j - 1)) == bucket) j--;
+        Count len = (Count)(i - j + 1);
+        end[bucket] -= len;
+        if (len == 1) out[end[bucket]] = in[i];
+        else std::copy(in.begin() + j, in.begin() + i + 1, out.begin() + end[bucket]);
+        i = j - 1;
+        bucket = prev;
+    }
+}
+
+// --- Classification ---
+
+Classifier linearClassifier(int minKey, int maxKey, uint32_t buckets) {
+    uint64_t range = (uint64_t)((long long)maxKey - minKey) + 1;
+    if (buckets >= range) return shiftClassifier(minKey, maxKey, 0);
+    Classifier c = {};
+    c.mode = Classifier::LINEAR;
+    c.minKey = minKey;
+    c.buckets = buckets;
+    // buckets < range keeps scale below 2^32 and every bucket below `buckets`
+    c.scale = (uint32_t)(((uint64_t)buckets << 32) / range);
+    return c;
+}
+
+Classifier shiftClassifier(int minKey, int maxKey, int shift) {
+    Classifier c = {};
+    c.mode = Classifier::SHIFT;
+    c.minKey = minKey;
+    c.shift = shift;
+    c.buckets = (uint32_t)((uint32_t)((long long)maxKey - minKey) >> shift) + 1;
+    return c;
+}
+
+Classifier splitterClassifier(const std::vector<int>& sortedSplitters) {
+    Classifier c = {};
+    c.mode = Classifier::SPLITTERS;
+    while (((size_t)1 << c.levels) < sortedSplitters.size() + 1) c.levels++;
+    c.buckets = 1u << c.levels;
+    // INT_MAX padding sends keys above the last splitter to bucket
+    // sortedSplitters.size(); only the buckets after it stay empty
+    std::vector<int> padded(sortedSplitters);
+    padded.resize(c.buckets - 1, INT_MAX);
+
+    // In-order walk of the implicit tree (children of j at 2j, 2j + 1) places the
+    // sorted splitters so that descending compares key > tree[j] at every level
+    c.tree.assign(c.buckets, 0);
+    size_t next = 0;
+    std::vector<size_t> stack;
+    size_t j = 1;
+    while (j < c.buckets || !stack.empty()) {
+        if (j < c.buckets) {
+            stack.push_back(j);
+            j = 2 * j;
+        } else {
+            j = stack.back();
+            stack.pop_back();
+            c.tree[j] = padded[next++];
+            j = 2 * j + 1;
+        }
+    }
+    return c;
+}
+
+void classifyKeys(const Classifier& c, const int* keys, size_t n, uint32_t* out) {
+    size_t i = 0;
+    const uint32_t base = (uint32_t)c.minKey;
+
+#if defined(__AVX512F__)
+    // GCC 12's unmasked forms merge into _mm512_undefined and trip
+    // -Wmaybe-uninitialized; zero-masked with every lane set, they are the same
+    // instructions
+    const __mmask8 all8 = 0xFF;
+    const __mmask16 all16 = 0xFFFF;
+    const __m512i vBase = _mm512_set1_epi32(c.minKey);
+    if (c.mode == Classifier::LINEAR) {
+        // 32x32 -> 64-bit products for the even and odd lanes, high halves merged back
+        const __m512i vScale = _mm512_set1_epi64(c.scale);
+        for (; i + 16 <= n; i += 16) {
+            __m512i off = _mm512_sub_epi32(_mm512_loadu_si512(keys + i), vBase);
+            __m512i even = _mm512_maskz_srli_epi64(all8, _mm512_maskz_mul_epu32(all8, off, vScale), 32);
+            __m512i odd = _mm512_maskz_mul_epu32(all8, _mm512_maskz_srli_epi64(all8, off, 32), vScale);
+            __m512i bucket = _mm512_mask_blend_epi32(0xAAAA, even, odd);
+            _mm512_storeu_si512(out + i, bucket);
+        }
+    } else if (c.mode == Classifier::SHIFT) {
+        const __m128i vShift = _mm_cvtsi32_si128(c.shift);
+        for (; i + 16 <= n; i += 16) {
+            __m512i off = _mm512_sub_epi32(_mm512_loadu_si512(keys + i), vBase);
+            _mm512_storeu_si512(out + i, _mm512_maskz_srl_epi32(all16, off, vShift));
+        }
+    } else {
+        const __m512i one = _mm512_set1_epi32(1);
+        for (; i + 16 <= n; i += 16) {
+            __m512i key = _mm512_loadu_si512(keys + i);
+            __m512i j = one;
+            for (int l = 0; l < c.levels; l++) {
+                __m512i splitter = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), all16, j, c.tree.data(), 4);
+                __mmask16 right = _mm512_cmpgt_epi32_mask(key, splitter);
+                j = _mm512_add_epi32(j, j);
+                j = _mm512_mask_add_epi32(j, right, j, one);
+            }
+            _mm512_storeu_si512(out + i, _mm512_sub_epi32(j, _mm512_set1_epi32(c.buckets)));
+        }
+    }
+#elif defined(__AVX2__)
+    const __m256i vBase = _mm256_set1_epi32(c.minKey);
+    if (c.mode == Classifier::LINEAR) {
+        const __m256i vScale = _mm256_set1_epi64x(c.scale);
+        for (; i + 8 <= n; i += 8) {
+            __m256i off = _mm256_sub_epi32(_mm256_loadu_si256((const __m256i*)(keys + i)), vBase);
+            __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(off, vScale), 32);
+            __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(off, 32), vScale);
+            __m256i bucket = _mm256_blend_epi32(even, odd, 0xAA);
+            _mm256_storeu_si256((__m256i*)(out + i), bucket);
+        }
+    } else if (c.mode == Classifier::SHIFT) {
+        const __m128i vShift = _mm_cvtsi32_si128(c.shift);
+        for (; i + 8 <= n; i += 8) {
+            __m256i off = _mm256_sub_epi32(_mm256_loadu_si256((const __m256i*)(keys + i)), vBase);
+            _mm256_storeu_si256((__m256i*)(out + i), _mm256_srl_epi32(off, vShift));
+        }
+    } else {
+        const __m256i one = _mm256_set1_epi32(1);
+        for (; i + 8 <= n; i += 8) {
+            __m256i key = _mm256_loadu_si256((const __m256i*)(keys + i));
+            __m256i j = one;
+            for (int l = 0; l < c.levels; l++) {
+                __m256i splitter = _mm256_i32gather_epi32(c.tree.data(), j, 4);
+                // cmpgt gives -1 where the key goes right: j = 2j + 1
+                __m256i right = _mm256_cmpgt_epi32(key, splitter);
+                j = _mm256_sub_epi32(_mm256_add_epi32(j, j), right);
+            }
+            _mm256_storeu_si256((__m256i*)(out + i), _mm256_sub_epi32(j, _mm256_set1_epi32(c.buckets)));
+        }
+    }
+#endif
+
+    // Scalar path, and the tail of the vector loops
+    if (c.mode == Classifier::LINEAR) {
+        for (; i < n; i++) out[i] = (uint32_t)(((uint64_t)((uint32_t)keys[i] - base) * c.scale) >> 32);
+    } else if (c.mode == Classifier::SHIFT) {
+        for (; i < n; i++) out[i] = ((uint32_t)keys[i] - base) >> c.shift;
+    } else {
+        for (; i < n; i++) {
+            uint32_t j = 1;
+            for (int l = 0; l < c.levels; l++) j = 2 * j + (keys[i] > c.tree[j]);
+            out[i] = j - c.buckets;
+        }
+    }
+}
+
+static const size_t CLASSIFY_BLOCK = 256; // Keys staged per kernel call; stays in L1
+
+template <typename R>
+void classify(const Classifier& c, const R* recs, size_t n, uint32_t* out) {
+    int keys[CLASSIFY_BLOCK];
+    for (size_t begin = 0; begin < n; begin += CLASSIFY_BLOCK) {
+        size_t count = std::min(CLASSIFY_BLOCK, n - begin);
+        for (size_t i = 0; i < count; i++) keys[i] = recs[begin + i].key;
+        classifyKeys(c, keys, count, out + begin);
+    }
+}
+
+// Classifies recs block by block and calls fn(i, bucket) for each record in order.
+// The ids only live in an L1-sized buffer, so a pass that needs them twice (count,
+// then scatter) reclassifies instead of streaming 4 bytes per record through DRAM.
+// A shift is a single instruction, cheaper than staging keys for the batched
+// kernel, so SHIFT buckets are computed in the loop itself.
+template <typename R, typename Fn>
+static void forEachBucket(const Classifier& c, const R* recs, size_t n, Fn fn) {
+    if (c.mode == Classifier::SHIFT) {
+        const uint32_t base = (uint32_t)c.minKey;
+        for (size_t i = 0; i < n; i++) fn(i, ((uint32_t)recs[i].key - base) >> c.shift);
+        return;
+    }
+    uint32_t ids[CLASSIFY_BLOCK];
+    for (size_t begin = 0; begin < n; begin += CLASSIFY_BLOCK) {
+        size_t count = std::min(CLASSIFY_BLOCK, n - begin);
+        classify(c, recs + begin, count, ids);
+        for (size_t i = 0; i < count; i++) fn(begin + i, ids[i]);
+    }
+}
+
+const char* classifyIsa() {
+#if defined(__AVX512F__)
+    return "AVX-512";
+#elif defined(__AVX2__)
+    return "AVX2";
+#else
+    return "scalar";
+#endif
+}
+
+// --- Small-key specialization (8- and 16-bit keys) ---
+
+// Keys of at most 16 bits that fit a fixed counter table without getMinMax
+template <typename R>
+struct HasSmallKey {
+    using Key = std::remove_cv_t<decltype(R::key)>;
+    static constexpr bool value = std::is_integral<Key>::value && sizeof(Key) <= 2;
+};
+
+// Table slot of a small key; signed keys are biased so slot order is key order
+template <typename Key>
+static inline size_t smallKeySlot(Key key) {
+    using U = std::make_unsigned_t<Key>;
+    U u = (U)key;
+    if (std::is_signed<Key>::value) u ^= (U)((U)1 << (8 * sizeof(Key) - 1));
+    return u;
+}
+
+// Above this many records, one range-sized scatter (the generic counting sort)
+// beats two byte passes over 16-bit keys: each record is moved once, not twice
+static const size_t SMALL_KEY16_MAX_N = 1 << 19;
+
+// Exclusive prefix over one 256-entry table: count[v] becomes the first output
+// slot of byte v (walked from the top slot down for descending order)
+static void smallKeyPrefix(uint32_t* count, SortOrder order) {
+    uint32_t pos = 0;
+    for (size_t step = 0; step < 256; step++) {
+        size_t v = (order == SortOrder::Ascending) ? step : 255 - step;
+        uint32_t c = count[v];
+        count[v] = pos;
+        pos += c;
+    }
+}
+
+// Stable counting sort over fixed 256-entry tables (1 KB of uint32 counters that
+// stay in L1), without getMinMax. 8-bit keys take a single pass. 16-bit keys
+// take two byte passes (LSD): one 65536-way scatter misses L1 and the TLB on
+// nearly every record, and a 256 KB table costs more to clear and prefix than
+// small inputs cost to sort.
+template <typename R>
+static void countingSortSmallKey(std::vector<R>& arr, SortOrder order) {
+    using Key = typename HasSmallKey<R>::Key;
+    size_t n = arr.size();
+
+    TraceScope phase("countingSortSmallKey", "histogram");
+    if (sizeof(Key) == 1) {
+        // Four interleaved sub-histograms: runs of equal keys no longer serialise
+        // on one counter's load-increment-store chain, so the loop issues ~4 wide
+        uint32_t sub[4][256] = {};
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            sub[0][smallKeySlot(arr[i].key)]++;
+            sub[1][smallKeySlot(arr[i + 1].key)]++;
+            sub[2][smallKeySlot(arr[i + 2].key)]++;
+            sub[3][smallKeySlot(arr[i + 3].key)]++;
+        }
+        for (; i < n; i++) sub[0][smallKeySlot(arr[i].key)]++;
+        uint32_t count[256];
+        for (size_t v = 0; v < 256; v++) count[v] = sub[0][v] + sub[1][v] + sub[2][v] + sub[3][v];
+
+        phase.next("prefix");
+        smallKeyPrefix(count, order);
+
+        // Left-to-right scatter keeps equal keys in input order
+        phase.next("scatter");
+        std::vector<R> output(n);
+        for (const auto& rec : arr) {
+            output[count[smallKeySlot(rec.key)]++] = rec;
+        }
+
+        phase.next("copy back");
+        arr.swap(output);
+        return;
+    }
+
+    // Both byte histograms come from one read
+    uint32_t count[2][256] = {};
+    for (const auto& rec : arr) {
+        size_t slot = smallKeySlot(rec.key);
+        count[0][slot & 255]++;
+        count[1][slot >> 8]++;
+    }
+
+    std::vector<R> buffer(n);
+    R* src = arr.data();
+    R* dst = buffer.data();
+    size_t first = smallKeySlot(arr[0].key);
+    for (int pass = 0; pass < 2; pass++) {
+        int bits = 8 * pass;
+        if (count[pass][(first >> bits) & 255] == n) continue; // Same byte in every key
+        phase.next("prefix");
+        smallKeyPrefix(count[pass], order);
+        phase.next("scatter");
+        for (size_t i = 0; i < n; i++) {
+            dst[count[pass][(smallKeySlot(src[i].key) >> bits) & 255]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+
+    phase.next("copy back");
+    if (src != arr.data()) arr.swap(buffer);
+}
+
 // --- 1. Counting Sort (Stable) ---
-void countingSortStable(std::vector<Record>& arr) {
+template <typename R>
+void countingSortStable(std::vector<R>& arr, SortOrder order) {
     if (arr.empty()) return;
+    if constexpr (HasSmallKey<R>::value) {
+        constexpr bool byteKey = sizeof(typename HasSmallKey<R>::Key) == 1;
+        if (byteKey ? arr.size() <= UINT32_MAX : arr.size() <= SMALL_KEY16_MAX_N) {
+            countingSortSmallKey(arr, order);
+            return;
+        }
+    }
 
     int minVal, maxVal;
     getMinMax(arr, minVal, maxVal);
     int range = maxVal - minVal + 1;
 
+    TraceScope phase("countingSortStable", "histogram");
     std::vector<int> count(range, 0);
-    std::vector<Record> output(arr.size());
+    std::vector<R> output(arr.size());
 
     // 1. Frequency Count
     for (const auto& rec : arr) {
         count[rec.key - minVal]++;
     }
+    // Adjacent equal keys decide the scatter; counting them inside the loop
+    // above slowed the histogram, so they get their own pass
+    size_t repeats = 0;
+    if (runScatter) {
+        for (size_t i = 1; i < arr.size(); i++) repeats += (arr[i].key == arr[i - 1].key);
+    }
 
-    // 2. Cumulative Count
-    for (int i = 1; i < range; i++) {
-        count[i] += count[i - 1];
+    // 2. Cumulative Count (from the top for descending: count[i] = keys >= i)
+    phase.next("prefix");
+    if (order == SortOrder::Ascending) {
+        for (int i = 1; i < range; i++) {
+            count[i] += count[i - 1];
+        }
+    } else {
+        for (int i = range - 2; i >= 0; i--) {
+            count[i] += count[i + 1];
+        }
     }
 
     // 3. Build Output (Right-to-Left for Stability)
-    for (int i = arr.size() - 1; i >= 0; i--) {
-        int idx = arr[i].key - minVal;
-        output[count[idx] - 1] = arr[i];
-        count[idx]--;
+    phase.next("scatter");
+    // Runs only pay once the mean run length reaches 2; shorter ones cost a
+    // second key load and a mispredicted run test per record
+    if (runScatter && 2 * repeats >= arr.size()) {
+        scatterRuns(arr, output, count.data(), [&arr, minVal](size_t i) { return arr[i].key - minVal; });
+    } else {
+        for (int i = arr.size() - 1; i >= 0; i--) {
+            int idx = arr[i].key - minVal;
+            output[count[idx] - 1] = arr[i];
+            count[idx]--;
+        }
     }
 
     // 4. Copy back
+    phase.next("copy back");
     arr = output;
 }
 
 // --- 2. Counting Sort (Non-Stable) ---
-void countingSortUnstable(std::vector<Record>& arr) {
+template <typename R>
+void countingSortUnstable(std::vector<R>& arr) {
     if (arr.empty()) return;
 
     int minVal, maxVal;
     getMinMax(arr, minVal, maxVal);
     int range = maxVal - minVal + 1;
 
+    TraceScope phase("countingSortUnstable", "histogram");
     std::vector<int> count(range, 0);
 
     // 1. Frequency Count
@@ -62,6 +536,7 @@ void countingSortUnstable(std::vector<Record>& arr) {
     }
 
     // 2. Overwrite input array
+    phase.next("copy back");
     // This destroys the original 'Record' structure association (instability)
     int index = 0;
     for (int i = 0; i < range; i++) {
@@ -76,8 +551,17 @@ void countingSortUnstable(std::vector<Record>& arr) {
 }
 
 // --- 3. LSD Radix Sort ---
-void radixSortLSD(std::vector<Record>& arr) {
+template <typename R>
+void radixSortLSD(std::vector<R>& arr, SortOrder order) {
     if (arr.empty()) return;
+    // 8- and 16-bit keys use the fixed 256-entry tables: one byte pass for 8-bit
+    // keys, two for 16-bit keys, and no min/max
+    if constexpr (HasSmallKey<R>::value) {
+        if (arr.size() <= UINT32_MAX) {
+            countingSortSmallKey(arr, order);
+            return;
+        }
+    }
 
     int minVal, maxVal;
     getMinMax(arr, minVal, maxVal);
@@ -87,23 +571,58 @@ void radixSortLSD(std::vector<Record>& arr) {
     for(auto& r : arr) r.key += shift;
     int maxKey = maxVal + shift;
 
-    // Do counting sort for every digit. exp is 10^i
-    for (int exp = 1; maxKey / exp > 0; exp *= 10) {
+    // Run scatter keeps each pass's digits for its repeat count and scatter
+    std::vector<uint8_t> digits(runScatter ? arr.size() : 0);
+
+    // Do counting sort for every digit. exp is 10^i (64-bit so that 10^10 does
+    // not overflow once keys reach 10^9; each pass divides by the int copy)
+    for (long long nextExp = 1; maxKey / nextExp > 0; nextExp *= 10) {
+        int exp = (int)nextExp;
+        TraceScope phase("radixSortLSD", "histogram");
         int n = arr.size();
-        std::vector<Record> output(n);
+        std::vector<R> output(n);
         int count[10] = {0};
 
-        for (int i = 0; i < n; i++)
-            count[(arr[i].key / exp) % 10]++;
+        // Kept digits spare the scatter its second divide
+        size_t repeats = 0;
+        if (runScatter) {
+            for (int i = 0; i < n; i++) {
+                digits[i] = (arr[i].key / exp) % 10;
+                count[digits[i]]++;
+            }
+            for (int i = 1; i < n; i++) repeats += (digits[i] == digits[i - 1]);
+        } else {
+            for (int i = 0; i < n; i++)
+                count[(arr[i].key / exp) % 10]++;
+        }
 
-        for (int i = 1; i < 10; i++)
-            count[i] += count[i - 1];
+        // Descending accumulates from digit 9 down, so larger digits come first
+        phase.next("prefix");
+        if (order == SortOrder::Ascending) {
+            for (int i = 1; i < 10; i++)
+                count[i] += count[i - 1];
+        } else {
+            for (int i = 8; i >= 0; i--)
+                count[i] += count[i + 1];
+        }
 
-        for (int i = n - 1; i >= 0; i--) {
-            int digit = (arr[i].key / exp) % 10;
-            output[count[digit] - 1] = arr[i];
-            count[digit]--;
+        phase.next("scatter");
+        auto scatter = [&](auto digitOf) {
+            for (int i = n - 1; i >= 0; i--) {
+                int digit = digitOf(i);
+                output[count[digit] - 1] = arr[i];
+                count[digit]--;
+            }
+        };
+        // With ten digits, runs only pay once the mean run length reaches 2
+        if (runScatter && 2 * repeats >= (size_t)n) {
+            scatterRuns(arr, output, count, [&digits](size_t i) { return digits[i]; });
+        } else if (runScatter) {
+            scatter([&digits](int i) { return digits[i]; });
+        } else {
+            scatter([&arr, exp](int i) { return (arr[i].key / exp) % 10; });
         }
+        phase.next("copy back");
         arr = output;
     }
 
@@ -114,55 +633,1253 @@ void radixSortLSD(std::vector<Record>& arr) {
 }
 
 // --- 4. Bucket Sort ---
-void bucketSort(std::vector<Record>& arr) {
-    if (arr.empty()) return;
-    
-    int minVal, maxVal;
-    getMinMax(arr, minVal, maxVal);
-    
+
+static const size_t BUCKET_SMALL = 32;          // Insertion-sort leaf up to this size
+static const long long BUCKET_DENSE_FACTOR = 4; // Counting leaf while the sub-range <= 4x the size
+static const int BUCKET_MAX_DEPTH = 3;          // Rebucketing levels before the radix fallback
+
+template <typename R>
+static void getMinMaxUntraced(const std::vector<R>& arr, int& minVal, int& maxVal) {
+    minVal = arr[0].key;
+    maxVal = arr[0].key;
+    for (const auto& rec : arr) {
+        minVal = std::min<int>(minVal, rec.key);
+        maxVal = std::max<int>(maxVal, rec.key);
+    }
+}
+
+// Stable counting sort of one bucket whose keys lie in [minVal, maxVal]
+template <typename R>
+static void countingSortLeaf(std::vector<R>& bucket, int minVal, int maxVal) {
+    std::vector<size_t> count((size_t)((long long)maxVal - minVal) + 2, 0);
+    for (const auto& rec : bucket) count[rec.key - minVal + 1]++;
+    for (size_t v = 1; v < count.size(); v++) count[v] += count[v - 1];
+    std::vector<R> output(bucket.size());
+    for (const auto& rec : bucket) output[count[rec.key - minVal]++] = rec;
+    bucket.swap(output);
+}
+
+// One bucketing pass over [minVal, maxVal]. Each bucket is finished by the
+// cheapest leaf for its size and own key range: insertion sort if small, nothing
+// if all keys are equal, counting sort if the sub-range is dense. A bucket that
+// overflows (more than BUCKET_SMALL records where one is expected) with a sparse
+// sub-range is rebucketed, and below BUCKET_MAX_DEPTH handed to the base-256
+// radix sort instead, so no input costs more than a few linear passes.
+// `phase` is null below the top level.
+template <typename R>
+static void bucketPass(std::vector<R>& arr, int minVal, int maxVal, int depth, TraceScope* phase) {
     int n = arr.size();
     int bucketCount = n; 
-    std::vector<std::vector<Record>> buckets(bucketCount);
-    long long range = (long long)maxVal - minVal + 1;
+    std::vector<std::vector<R>> buckets(bucketCount);
+
+    // Bucket ids from the shared kernel (fixed-point multiply instead of a divide and clamp)
+    forEachBucket(linearClassifier(minVal, maxVal, bucketCount), arr.data(), n,
+                  [&](size_t i, uint32_t b) { buckets[b].push_back(arr[i]); });
     
-    for (int i = 0; i < n; i++) {
-        int idx = (int)(((long long)(arr[i].key - minVal) * bucketCount) / range);
-        if (idx >= bucketCount) idx = bucketCount - 1;
-        buckets[idx].push_back(arr[i]);
+    if (phase) phase->next("bucket sort");
+    for (int i = 0; i < bucketCount; i++) {
+        std::vector<R>& bucket = buckets[i];
+        size_t size = bucket.size();
+        if (size < 2) continue;
+        if (size <= BUCKET_SMALL) {
+            insertionSortRecords(bucket.data(), size);
+            continue;
+        }
+        // The bucket is cache-resident now, so its own min / max costs little
+        int lo, hi;
+        getMinMaxUntraced(bucket, lo, hi);
+        if (lo == hi) continue; // Equal keys stay in input order
+        if ((long long)hi - lo + 1 <= BUCKET_DENSE_FACTOR * (long long)size) {
+            countingSortLeaf(bucket, lo, hi);
+        } else if (depth < BUCKET_MAX_DEPTH) {
+            bucketPass(bucket, lo, hi, depth + 1, nullptr);
+        } else {
+            radixSortParallel(bucket, 1); // Stable, at most 4 passes
+        }
     }
-    
+
+    if (phase) phase->next("copy back");
     int index = 0;
     for (int i = 0; i < bucketCount; i++) {
-        // We use stable_sort to ensure the overall Bucket Sort is stable
-        std::stable_sort(buckets[i].begin(), buckets[i].end(), 
-            [](const Record& a, const Record& b) {
-                return a.key < b.key;
-            });
-            
         for (const auto& item : buckets[i]) {
             arr[index++] = item;
         }
     }
 }
 
+template <typename R>
+void bucketSort(std::vector<R>& arr) {
+    if (arr.empty()) return;
+    
+    int minVal, maxVal;
+    getMinMax(arr, minVal, maxVal);
+    
+    TraceScope phase("bucketSort", "scatter");
+    bucketPass(arr, minVal, maxVal, 0, &phase);
+}
+
 // --- 5. Pigeonhole Sort ---
-void pigeonholeSort(std::vector<Record>& arr) {
+template <typename R>
+void pigeonholeSort(std::vector<R>& arr) {
     if (arr.empty()) return;
 
     int minVal, maxVal;
     getMinMax(arr, minVal, maxVal);
     int range = maxVal - minVal + 1;
 
-    std::vector<std::vector<Record>> holes(range);
+    TraceScope phase("pigeonholeSort", "scatter");
+    std::vector<std::vector<R>> holes(range);
 
     for (const auto& rec : arr) {
         holes[rec.key - minVal].push_back(rec);
     }
 
+    phase.next("copy back");
     int index = 0;
     for (int i = 0; i < range; i++) {
         for (const auto& rec : holes[i]) {
             arr[index++] = rec;
         }
     }
-}
\ No newline at end of file
+}
+
+// --- 6. Key-Index Sort ---
+template <typename R>
+void sortByKeyIndex(std::vector<R>& arr, void (*keySort)(std::vector<Record>&)) {
+    if (arr.empty()) return;
+
+    // 1. Extract compact {key, original index} pairs
+    int n = arr.size();
+    std::vector<Record> keys(n);
+    for (int i = 0; i < n; i++) {
+        keys[i] = {arr[i].key, i};
+    }
+
+    // 2. Sort the 8-byte pairs; a stable keySort keeps equal keys in index order
+    keySort(keys);
+
+    // 3. Gather the wide records once
+    std::vector<R> output(n);
+    for (int i = 0; i < n; i++) {
+        output[i] = arr[keys[i].id];
+    }
+    arr.swap(output);
+}
+
+// --- 7. Indirect Counting Sort ---
+template <typename R>
+void countingSortIndirect(std::vector<R>& arr) {
+    if (arr.empty()) return;
+
+    int minVal, maxVal;
+    getMinMax(arr, minVal, maxVal);
+    int range = maxVal - minVal + 1;
+
+    std::vector<int> count(range, 0);
+    std::vector<const R*> order(arr.size());
+
+    // 1. Frequency Count
+    for (const auto& rec : arr) {
+        count[rec.key - minVal]++;
+    }
+
+    // 2. Cumulative Count
+    for (int i = 1; i < range; i++) {
+        count[i] += count[i - 1];
+    }
+
+    // 3. Scatter pointers (Right-to-Left for Stability)
+    for (int i = arr.size() - 1; i >= 0; i--) {
+        int idx = arr[i].key - minVal;
+        order[count[idx] - 1] = &arr[i];
+        count[idx]--;
+    }
+
+    // 4. Gather records in pointer order
+    std::vector<R> output(arr.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        output[i] = *order[i];
+    }
+    arr.swap(output);
+}
+
+// --- Thread helpers for the parallel kernels ---
+static bool pinThreads = false;
+
+void setThreadPinning(bool enabled) {
+    pinThreads = enabled;
+}
+
+static void pinCurrentThread(int t) {
+#ifdef __linux__
+    if (!pinThreads) return;
+    int cpus = std::max(1u, std::thread::hardware_concurrency());
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(t % cpus, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)t;
+#endif
+}
+
+// Runs fn(t) for t in [0, threads) and waits for all of them
+template <typename Fn>
+static void runOnThreads(int threads, Fn fn) {
+    if (threads <= 1) {
+        fn(0);
+        return;
+    }
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back([&fn, t] {
+            pinCurrentThread(t);
+            fn(t);
+        });
+    }
+    for (auto& th : pool) th.join();
+}
+
+// [begin, end) of thread t's chunk
+static size_t chunkBegin(size_t n, int threads, int t) {
+    return n * t / threads;
+}
+
+template <typename R>
+static void getMinMaxParallel(const std::vector<R>& arr, int threads, int& minVal, int& maxVal) {
+    std::vector<int> mins(threads, arr[0].key), maxs(threads, arr[0].key);
+    runOnThreads(threads, [&](int t) {
+        TraceScope phase("getMinMax", "getMinMax");
+        size_t begin = chunkBegin(arr.size(), threads, t), end = chunkBegin(arr.size(), threads, t + 1);
+        int lo = arr[0].key, hi = arr[0].key;
+        for (size_t i = begin; i < end; i++) {
+            lo = std::min<int>(lo, arr[i].key);
+            hi = std::max<int>(hi, arr[i].key);
+        }
+        mins[t] = lo;
+        maxs[t] = hi;
+    });
+    minVal = *std::min_element(mins.begin(), mins.end());
+    maxVal = *std::max_element(maxs.begin(), maxs.end());
+}
+
+// --- 8. Parallel Counting Sort (Stable) ---
+template <typename R>
+void countingSortParallel(std::vector<R>& arr, int threads) {
+    if (arr.empty()) return;
+    threads = std::max(1, (int)std::min<size_t>(std::max(1, threads), arr.size()));
+    size_t n = arr.size();
+
+    int minVal, maxVal;
+    getMinMaxParallel(arr, threads, minVal, maxVal);
+    int range = maxVal - minVal + 1;
+
+    // 1. Per-thread frequency counts over each thread's chunk
+    std::vector<std::vector<size_t>> count(threads);
+    runOnThreads(threads, [&](int t) {
+        TraceScope phase("countingSortParallel", "histogram");
+        count[t].assign(range, 0);
+        size_t begin = chunkBegin(n, threads, t), end = chunkBegin(n, threads, t + 1);
+        for (size_t i = begin; i < end; i++) {
+            count[t][arr[i].key - minVal]++;
+        }
+    });
+
+    // 2. Exclusive prefix over (key, thread), split into one key block per thread:
+    //    block totals first, then each block fills its own start offsets
+    std::vector<size_t> blockTotal(threads + 1, 0);
+    runOnThreads(threads, [&](int t) {
+        TraceScope phase("countingSortParallel", "prefix");
+        size_t kBegin = chunkBegin(range, threads, t), kEnd = chunkBegin(range, threads, t + 1);
+        size_t sum = 0;
+        for (size_t v = kBegin; v < kEnd; v++)
+            for (int u = 0; u < threads; u++) sum += count[u][v];
+        blockTotal[t + 1] = sum;
+    });
+    for (int t = 0; t < threads; t++) blockTotal[t + 1] += blockTotal[t];
+
+    runOnThreads(threads, [&](int t) {
+        TraceScope phase("countingSortParallel", "prefix");
+        size_t kBegin = chunkBegin(range, threads, t), kEnd = chunkBegin(range, threads, t + 1);
+        size_t pos = blockTotal[t];
+        for (size_t v = kBegin; v < kEnd; v++) {
+            for (int u = 0; u < threads; u++) {
+                size_t c = count[u][v];
+                count[u][v] = pos;
+                pos += c;
+            }
+        }
+    });
+
+    // 3. Scatter (Left-to-Right within each chunk, chunks in order => stable)
+    std::vector<R> output(n);
+    runOnThreads(threads, [&](int t) {
+        TraceScope phase("countingSortParallel", "scatter");
+        size_t begin = chunkBegin(n, threads, t), end = chunkBegin(n, threads, t + 1);
+        std::vector<size_t>& offset = count[t];
+        for (size_t i = begin; i < end; i++) {
+            output[offset[arr[i].key - minVal]++] = arr[i];
+        }
+    });
+
+    // 4. Hand the buffer over instead of copying back
+    arr.swap(output);
+}
+
+// --- 9. Parallel LSD Radix Sort ---
+template <typename R>
+void radixSortParallel(std::vector<R>& arr, int threads) {
+    if (arr.empty()) return;
+    threads = std::max(1, (int)std::min<size_t>(std::max(1, threads), arr.size()));
+    size_t n = arr.size();
+
+    int minVal, maxVal;
+    getMinMaxParallel(arr, threads, minVal, maxVal);
+
+    // Digits are taken from (key - minVal), so negatives need no shifting pass
+    unsigned maxOffset = (unsigned)((long long)maxVal - minVal);
+    int passes = 1;
+    while (passes < 4 && (maxOffset >> (8 * passes)) != 0) passes++;
+
+    std::vector<R> buffer(n);
+    std::vector<R>* src = &arr;
+    std::vector<R>* dst = &buffer;
+    std::vector<std::vector<size_t>> count(threads, std::vector<size_t>(256));
+
+    for (int pass = 0; pass < passes; pass++) {
+        int shift = 8 * pass;
+        auto digitOf = [minVal, shift](const R& r) {
+            return ((unsigned)((long long)r.key - minVal) >> shift) & 0xFF;
+        };
+
+        // 1. Per-thread digit counts
+        runOnThreads(threads, [&](int t) {
+            TraceScope phase("radixSortParallel", "histogram");
+            std::fill(count[t].begin(), count[t].end(), 0);
+            size_t begin = chunkBegin(n, threads, t), end = chunkBegin(n, threads, t + 1);
+            for (size_t i = begin; i < end; i++) count[t][digitOf((*src)[i])]++;
+        });
+
+        // 2. Exclusive prefix over (digit, thread)
+        TraceScope prefix("radixSortParallel", "prefix");
+        size_t pos = 0;
+        for (int d = 0; d < 256; d++) {
+            for (int t = 0; t < threads; t++) {
+                size_t c = count[t][d];
+                count[t][d] = pos;
+                pos += c;
+            }
+        }
+        prefix.end();
+
+        // 3. Stable scatter
+        runOnThreads(threads, [&](int t) {
+            TraceScope phase("radixSortParallel", "scatter");
+            size_t begin = chunkBegin(n, threads, t), end = chunkBegin(n, threads, t + 1);
+            std::vector<size_t>& offset = count[t];
+            for (size_t i = begin; i < end; i++) {
+                const R& r = (*src)[i];
+                (*dst)[offset[digitOf(r)]++] = r;
+            }
+        });
+        std::swap(src, dst);
+    }
+
+    if (src != &arr) arr.swap(buffer);
+}
+
+// --- Verification ---
+
+// splitmix64 finaliser over the packed (key, id) pair
+static inline uint64_t mixRecord(int key, int id) {
+    uint64_t z = ((uint64_t)(uint32_t)key << 32) | (uint32_t)id;
+    z += 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+template <typename R>
+uint64_t multisetHash(const std::vector<R>& arr, int threads) {
+    if (arr.empty()) return 0;
+    threads = std::max(1, (int)std::min<size_t>(std::max(1, threads), arr.size()));
+    std::vector<uint64_t> partial(threads, 0);
+    runOnThreads(threads, [&](int t) {
+        size_t begin = chunkBegin(arr.size(), threads, t), end = chunkBegin(arr.size(), threads, t + 1);
+        uint64_t h = 0;
+        for (size_t i = begin; i < end; i++) h += mixRecord(arr[i].key, arr[i].id);
+        partial[t] = h;
+    });
+    uint64_t h = 0;
+    for (uint64_t p : partial) h += p;
+    return h;
+}
+
+template <typename R>
+SortCheck verifySort(const std::vector<R>& arr, uint64_t inputHash, int threads, SortOrder order) {
+    SortCheck check = {true, true, true};
+    bool descending = (order == SortOrder::Descending);
+    if (arr.size() < 2) {
+        check.permutation = (multisetHash(arr, 1) == inputHash);
+        return check;
+    }
+    threads = std::max(1, (int)std::min<size_t>(std::max(1, threads), arr.size()));
+
+    std::vector<uint64_t> partialHash(threads, 0);
+    std::vector<char> unsorted(threads, 0), unstable(threads, 0);
+    runOnThreads(threads, [&](int t) {
+        size_t begin = chunkBegin(arr.size(), threads, t), end = chunkBegin(arr.size(), threads, t + 1);
+        // No early exit and no branches in the loop body, so the compiler can
+        // vectorise the comparisons and the hash together
+        uint64_t h = 0;
+        int badOrder = 0, badStable = 0;
+        if (begin == 0) {
+            h += mixRecord(arr[0].key, arr[0].id);
+            begin = 1;
+        }
+        for (size_t i = begin; i < end; i++) {
+            h += mixRecord(arr[i].key, arr[i].id);
+            int prevKey = arr[i - 1].key, key = arr[i].key;
+            badOrder |= descending ? (key > prevKey) : (key < prevKey);
+            badStable |= (key == prevKey) & (arr[i].id < arr[i - 1].id);
+        }
+        partialHash[t] = h;
+        unsorted[t] = badOrder;
+        unstable[t] = badStable;
+    });
+
+    uint64_t h = 0;
+    for (int t = 0; t < threads; t++) {
+        h += partialHash[t];
+        if (unsorted[t]) check.sorted = false;
+        if (unstable[t]) check.stable = false;
+    }
+    check.permutation = (h == inputHash);
+    return check;
+}
+
+// --- Key statistics ---
+
+static const int PROFILE_BLOCK = 64;        // Keys per descent mask
+static const size_t PROFILE_SAMPLES = 4096; // Sampled keys behind the histogram and distinct estimate
+
+static inline uint64_t mixKey(uint64_t key) {
+    uint64_t z = key + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Fibonacci hashing. Multiplying by an odd constant is a bijection, so equal
+// hashes mean equal keys and the top bits still depend on every key bit
+static inline uint32_t hashKey(int key) {
+    return (uint32_t)key * 0x9E3779B1u;
+}
+
+static inline int leadingZeros64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(x);
+#else
+    int zeros = 0;
+    while (!(x & (1ull << 63))) {
+        x <<= 1;
+        zeros++;
+    }
+    return zeros;
+#endif
+}
+
+static inline int trailingZeros64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int zeros = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        zeros++;
+    }
+    return zeros;
+#endif
+}
+
+static inline int popCount64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#else
+    int bits = 0;
+    for (; x; x &= x - 1) bits++;
+    return bits;
+#endif
+}
+
+// True if x has a run of at least k >= 1 set bits. Each step doubles the run
+// length the surviving bits stand for, so this takes O(log k) shifts
+static inline bool hasBitRun(uint64_t x, size_t k) {
+    for (size_t run = 1; x && run < k;) {
+        size_t step = std::min(run, k - run);
+        x &= x >> step;
+        run += step;
+    }
+    return x != 0;
+}
+
+static inline size_t longestBitRun(uint64_t x) {
+    size_t run = 0;
+    for (; x; x &= x >> 1) run++;
+    return run;
+}
+
+// Min, max, descents and runs of one chunk. A run ends at every descent; the
+// chunk keeps the run before its first descent (head), the run it ends in (tail)
+// and its longest, so runs that cross chunk boundaries can be joined
+struct KeyScan {
+    int lo, hi;
+    size_t descents, head, tail, longest;
+};
+
+// Folds the descent masks of consecutive blocks into descents and runs. A block
+// without descents only extends the current run
+struct RunTracker {
+    KeyScan& s;
+    bool seenDescent = false;
+    size_t run = 0;
+
+    void block(uint64_t mask) {
+        if (!mask) {
+            run += PROFILE_BLOCK;
+            return;
+        }
+        s.descents += popCount64(mask);
+        int first = trailingZeros64(mask), last = 63 - leadingZeros64(mask);
+        s.longest = std::max(s.longest, run + first);
+        if (!seenDescent) s.head = run + first;
+        seenDescent = true;
+        if (last > first) {
+            // A run between two descents is one longer than the zeros between them
+            uint64_t gaps = ~mask & ((1ull << last) - 1) & ~((2ull << first) - 1);
+            if (s.longest == 0 || hasBitRun(gaps, s.longest)) s.longest = std::max(s.longest, longestBitRun(gaps) + 1);
+        }
+        run = PROFILE_BLOCK - last;
+    }
+
+    void key(bool descent) {
+        if (descent) {
+            s.descents++;
+            s.longest = std::max(s.longest, run);
+            if (!seenDescent) s.head = run;
+            seenDescent = true;
+            run = 0;
+        }
+        run++;
+    }
+};
+
+// (key, id) pairs of 32-bit ints: the vector paths pull the keys out of two
+// loads of records, compare each key with the one before it (the previous
+// vector supplies the first), and keep min and max in registers
+template <typename R>
+struct IsIntPair {
+    static constexpr bool value = std::is_same<std::remove_cv_t<decltype(R::key)>, int>::value &&
+                                  sizeof(R) == 2 * sizeof(int) && offsetof(R, key) == 0;
+};
+
+// Min and max of whole blocks of (key, id) pairs, with each block's start and
+// descent mask passed to onBlock. Returns the number of records scanned
+template <typename Fn>
+static size_t scanPairBlocks(const int* pairs, size_t count, int prevKey, int& lo, int& hi, Fn onBlock) {
+    size_t i = 0;
+#if defined(__AVX512F__)
+    // Zero-masked forms, as in classifyKeys
+    const __mmask16 all16 = 0xFFFF;
+    const __m512i even = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+    __m512i vLo = _mm512_set1_epi32(lo), vHi = _mm512_set1_epi32(hi), last = _mm512_set1_epi32(prevKey);
+    for (; i + PROFILE_BLOCK <= count; i += PROFILE_BLOCK) {
+        uint64_t mask = 0;
+        for (int j = 0; j < PROFILE_BLOCK; j += 16) {
+            const int* p = pairs + 2 * (i + j);
+            __m512i key = _mm512_permutex2var_epi32(_mm512_loadu_si512(p), even, _mm512_loadu_si512(p + 16));
+            __m512i before = _mm512_maskz_alignr_epi32(all16, key, last, 15);
+            last = key;
+            vLo = _mm512_maskz_min_epi32(all16, vLo, key);
+            vHi = _mm512_maskz_max_epi32(all16, vHi, key);
+            mask |= (uint64_t)_mm512_mask_cmpgt_epi32_mask(all16, before, key) << j;
+        }
+        onBlock(i, mask);
+    }
+    int lanes[16];
+    _mm512_storeu_si512(lanes, vLo);
+    lo = *std::min_element(lanes, lanes + 16);
+    _mm512_storeu_si512(lanes, vHi);
+    hi = *std::max_element(lanes, lanes + 16);
+#elif defined(__AVX2__)
+    const __m256i even = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    const __m256i rotate = _mm256_setr_epi32(7, 0, 1, 2, 3, 4, 5, 6);
+    __m256i vLo = _mm256_set1_epi32(lo), vHi = _mm256_set1_epi32(hi), last = _mm256_set1_epi32(prevKey);
+    for (; i + PROFILE_BLOCK <= count; i += PROFILE_BLOCK) {
+        uint64_t mask = 0;
+        for (int j = 0; j < PROFILE_BLOCK; j += 8) {
+            const int* p = pairs + 2 * (i + j);
+            __m256i a = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i*)p), even);
+            __m256i b = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i*)(p + 8)), even);
+            __m256i key = _mm256_permute2x128_si256(a, b, 0x20);
+            __m256i before = _mm256_blend_epi32(_mm256_permutevar8x32_epi32(key, rotate),
+                                                _mm256_permutevar8x32_epi32(last, rotate), 1);
+            last = key;
+            vLo = _mm256_min_epi32(vLo, key);
+            vHi = _mm256_max_epi32(vHi, key);
+            mask |= (uint64_t)(uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(before, key))) << j;
+        }
+        onBlock(i, mask);
+    }
+    int lanes[8];
+    _mm256_storeu_si256((__m256i*)lanes, vLo);
+    lo = *std::min_element(lanes, lanes + 8);
+    _mm256_storeu_si256((__m256i*)lanes, vHi);
+    hi = *std::max_element(lanes, lanes + 8);
+#elif defined(__SSE2__)
+    // No packed 32-bit min or max before SSE4.1, so they select through the compare mask
+    __m128i vLo = _mm_set1_epi32(lo), vHi = _mm_set1_epi32(hi);
+    __m128 last = _mm_castsi128_ps(_mm_set1_epi32(prevKey));
+    for (; i + PROFILE_BLOCK <= count; i += PROFILE_BLOCK) {
+        uint64_t mask = 0;
+        for (int j = 0; j < PROFILE_BLOCK; j += 4) {
+            const float* p = (const float*)(pairs + 2 * (i + j));
+            __m128 keyPs = _mm_shuffle_ps(_mm_loadu_ps(p), _mm_loadu_ps(p + 4), _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 edge = _mm_shuffle_ps(last, keyPs, _MM_SHUFFLE(0, 0, 3, 3));
+            __m128i before = _mm_castps_si128(_mm_shuffle_ps(edge, keyPs, _MM_SHUFFLE(2, 1, 2, 0)));
+            last = keyPs;
+            __m128i key = _mm_castps_si128(keyPs);
+            __m128i below = _mm_cmplt_epi32(key, vLo), above = _mm_cmpgt_epi32(key, vHi);
+            vLo = _mm_or_si128(_mm_and_si128(below, key), _mm_andnot_si128(below, vLo));
+            vHi = _mm_or_si128(_mm_and_si128(above, key), _mm_andnot_si128(above, vHi));
+            mask |= (uint64_t)(uint32_t)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(before, key))) << j;
+        }
+        onBlock(i, mask);
+    }
+    int lanes[4];
+    _mm_storeu_si128((__m128i*)lanes, vLo);
+    lo = *std::min_element(lanes, lanes + 4);
+    _mm_storeu_si128((__m128i*)lanes, vHi);
+    hi = *std::max_element(lanes, lanes + 4);
+#else
+    (void)pairs, (void)count, (void)prevKey, (void)lo, (void)hi, (void)onBlock;
+#endif
+    return i;
+}
+
+// Stratified sample: one random position in each of r equal strata of the
+// array. The scan reads each sampled key while its block is in L1, so the
+// sample costs no random reads
+template <typename R>
+struct KeySampler {
+    const R* arr;
+    size_t n, r;
+    std::vector<int>& sample;
+    size_t next = 0, pos = 0; // Next stratum and its position
+
+    KeySampler(const R* arr, size_t n, size_t r, size_t from, std::vector<int>& sample)
+        : arr(arr), n(n), r(r), sample(sample) {
+        // Strata before the one holding from, less one for rounding, end below it
+        next = std::max<size_t>(from * r / n, 1) - 1;
+        pos = position(next);
+        while (pos < from) advance();
+    }
+
+    size_t position(size_t s) const {
+        if (s >= r) return SIZE_MAX;
+        size_t begin = s * n / r, end = (s + 1) * n / r;
+        return begin + (size_t)(((mixKey(s) >> 32) * (uint64_t)(end - begin)) >> 32);
+    }
+
+    void advance() { pos = position(++next); }
+
+    // Takes every sampled position below end
+    void take(size_t end) {
+        for (; pos < end; advance()) sample[next] = arr[pos].key;
+    }
+};
+
+// Each block of PROFILE_BLOCK keys is read by branch-free loops: min and max,
+// and a byte per descent that is then packed into a mask. Runs come from the
+// gaps between the mask's set bits. Only keys are read; nothing is hashed
+template <typename R>
+static void scanKeys(const R* arr, size_t begin, size_t count, int prevKey, KeyScan& s, KeySampler<R>& sampler) {
+    arr += begin;
+    s.lo = s.hi = arr[0].key;
+    s.descents = s.head = s.tail = s.longest = 0;
+    RunTracker runs{s};
+    size_t i = 0;
+    if constexpr (IsIntPair<R>::value) {
+        i = scanPairBlocks(reinterpret_cast<const int*>(arr), count, prevKey, s.lo, s.hi, [&](size_t j, uint64_t mask) {
+            runs.block(mask);
+            sampler.take(begin + j + PROFILE_BLOCK);
+        });
+        if (i > 0) prevKey = arr[i - 1].key;
+    }
+    for (; i + PROFILE_BLOCK <= count; i += PROFILE_BLOCK) {
+        const R* block = arr + i;
+        int lo = s.lo, hi = s.hi;
+        for (int j = 0; j < PROFILE_BLOCK; j++) {
+            lo = std::min<int>(lo, block[j].key);
+            hi = std::max<int>(hi, block[j].key);
+        }
+        s.lo = lo;
+        s.hi = hi;
+        uint8_t descent[PROFILE_BLOCK];
+        descent[0] = block[0].key < prevKey;
+        for (int j = 1; j < PROFILE_BLOCK; j++) descent[j] = block[j].key < block[j - 1].key;
+        prevKey = block[PROFILE_BLOCK - 1].key;
+
+        // Gather bit 0 of each of 8 bytes into the top byte
+        uint64_t mask = 0;
+        for (int w = 0; w < PROFILE_BLOCK / 8; w++) {
+            uint64_t bytes;
+            std::memcpy(&bytes, descent + 8 * w, 8);
+            mask |= ((bytes * 0x0102040810204080ull) >> 56) << (8 * w);
+        }
+        runs.block(mask);
+        sampler.take(begin + i + PROFILE_BLOCK);
+    }
+    for (; i < count; i++) {
+        int key = arr[i].key;
+        s.lo = std::min(s.lo, key);
+        s.hi = std::max(s.hi, key);
+        runs.key(key < prevKey);
+        prevKey = key;
+    }
+    sampler.take(begin + count);
+    if (!runs.seenDescent) s.head = count;
+    s.tail = runs.run;
+    s.longest = std::max(s.longest, runs.run);
+}
+
+// Distinct keys from the sample. f1 and f2 count the keys it holds once and
+// twice. Once most of the sample repeats keys (f1 < r / 2), it has met most of
+// the frequent ones and Chao1, d + f1(f1 - 1) / 2(f2 + 1), extrapolates the
+// rest. Below that the few doubletons say little, so each bin is filled as if
+// its keys were drawn uniformly over its width: w * (1 - e^(-count / w)). A
+// sample of all n keys gives the exact count
+static double estimateDistinct(const std::vector<int>& sample, size_t n, const std::vector<size_t>& histogram,
+                               double range) {
+    size_t slots = 2;
+    while (slots < 2 * sample.size()) slots *= 2;
+    std::vector<int> keys(slots);
+    std::vector<uint32_t> seen(slots, 0);
+    int bits = 0;
+    while (((size_t)1 << bits) < slots) bits++;
+    double d = 0, f1 = 0, f2 = 0;
+    for (int key : sample) {
+        size_t s = hashKey(key) >> (32 - bits);
+        while (seen[s] && keys[s] != key) s = (s + 1) & (slots - 1);
+        keys[s] = key;
+        uint32_t c = ++seen[s];
+        d += (c == 1);
+        f1 += (c == 1) - (c == 2);
+        f2 += (c == 2) - (c == 3);
+    }
+    if (sample.size() == n) return d;
+    if (2 * f1 < sample.size()) return d + f1 * (f1 - 1) / (2 * (f2 + 1));
+    double width = range / histogram.size(), filled = 0;
+    for (size_t count : histogram) filled += width * -std::expm1(-(double)count / width);
+    return std::max(d, filled);
+}
+
+template <typename R>
+KeyProfile profileKeys(const std::vector<R>& arr, int threads) {
+    KeyProfile p = {};
+    p.n = arr.size();
+    p.histogram.assign(KeyProfile::BINS, 0);
+    if (arr.empty()) return p;
+    size_t n = arr.size();
+    threads = std::max(1, (int)std::min<size_t>(std::max(1, threads), n));
+
+    size_t r = std::min(n, PROFILE_SAMPLES);
+    std::vector<int> sample(r);
+    std::vector<KeyScan> part(threads);
+    runOnThreads(threads, [&](int t) {
+        TraceScope phase("profileKeys", "scan");
+        size_t begin = chunkBegin(n, threads, t), end = chunkBegin(n, threads, t + 1);
+        KeySampler<R> sampler(arr.data(), n, r, begin, sample);
+        scanKeys(arr.data(), begin, end - begin, arr[begin > 0 ? begin - 1 : 0].key, part[t], sampler);
+    });
+
+    TraceScope merge("profileKeys", "merge");
+    size_t carry = 0; // Length of the run still open at the end of the previous chunks
+    p.minKey = part[0].lo;
+    p.maxKey = part[0].hi;
+    for (int t = 0; t < threads; t++) {
+        const KeyScan& pt = part[t];
+        p.minKey = std::min(p.minKey, pt.lo);
+        p.maxKey = std::max(p.maxKey, pt.hi);
+        p.descents += pt.descents;
+        size_t len = chunkBegin(n, threads, t + 1) - chunkBegin(n, threads, t);
+        p.longestRun = std::max(p.longestRun, pt.longest);
+        if (pt.head == len) {
+            carry += len;
+        } else {
+            p.longestRun = std::max(p.longestRun, carry + pt.head);
+            carry = pt.tail;
+        }
+    }
+    p.longestRun = std::max(p.longestRun, carry);
+    double range = (double)p.maxKey - p.minKey + 1;
+
+    // The histogram and the distinct estimate come from the PROFILE_SAMPLES
+    // sampled keys (every key while n is that small), binned over the exact range
+    // and scaled up to n
+    merge.next("sample");
+    // Fixed-point bin width: bin = offset * scale >> 32 stays below BINS for offset < range
+    uint64_t scale = ((uint64_t)KeyProfile::BINS << 32) / (uint64_t)range;
+    std::vector<size_t> sampleBins(KeyProfile::BINS, 0);
+    for (int key : sample) sampleBins[((uint64_t)((long long)key - p.minKey) * scale) >> 32]++;
+    for (int b = 0; b < KeyProfile::BINS; b++) p.histogram[b] = (size_t)((double)sampleBins[b] * n / r + 0.5);
+
+    // Strictly descending keys are all distinct
+    double distinct = p.descents == n - 1 ? (double)n : estimateDistinct(sample, n, p.histogram, range);
+    p.distinct = std::min({distinct, (double)n, range});
+    return p;
+}
+
+const char* sortKernelName(SortKernel kernel) {
+    switch (kernel) {
+        case SortKernel::AlreadySorted: return "Already Sorted";
+        case SortKernel::Reverse: return "Reverse";
+        case SortKernel::Counting: return "Counting Sort";
+        case SortKernel::Radix: return "Radix Sort";
+        case SortKernel::StableSort: return "std::stable_sort";
+    }
+    return "?";
+}
+
+static const size_t AUTO_SMALL_N = 256;     // Below this the histogram passes do not pay off
+static const long long AUTO_RANGE_PER_N = 4; // Counting sort while range <= 4n
+
+SortKernel chooseSortKernel(const KeyProfile& profile) {
+    if (profile.descents == 0) return SortKernel::AlreadySorted;
+    // Every step descends, so all keys differ and a reversal is stable
+    if (profile.descents == profile.n - 1) return SortKernel::Reverse;
+    long long range = (long long)profile.maxKey - profile.minKey + 1;
+    if (range <= AUTO_RANGE_PER_N * (long long)profile.n) return SortKernel::Counting;
+    if (profile.n < AUTO_SMALL_N) return SortKernel::StableSort;
+    return SortKernel::Radix;
+}
+
+template <typename R>
+SortKernel sortAuto(std::vector<R>& arr, int threads) {
+    SortKernel kernel = chooseSortKernel(profileKeys(arr, threads));
+    switch (kernel) {
+        case SortKernel::AlreadySorted:
+            break;
+        case SortKernel::Reverse:
+            std::reverse(arr.begin(), arr.end());
+            break;
+        case SortKernel::Counting:
+            if (threads > 1) countingSortParallel(arr, threads);
+            else countingSortStable(arr);
+            break;
+        case SortKernel::Radix:
+            radixSortParallel(arr, threads);
+            break;
+        case SortKernel::StableSort:
+            std::stable_sort(arr.begin(), arr.end(), [](const R& a, const R& b) { return a.key < b.key; });
+            break;
+    }
+    return kernel;
+}
+
+#ifdef __SIZEOF_INT128__
+// --- 10. 128-bit Radix Sort ---
+
+static inline int byteOf(Key128 key, int d) {
+    // Shifting one 64-bit half avoids a full 128-bit variable shift
+    uint64_t half = d < 8 ? (uint64_t)key : (uint64_t)(key >> 64);
+    return (int)((half >> (8 * (d & 7))) & 0xFF);
+}
+
+// Stable insertion sort for the small buckets left by the MSD partitioning
+static void insertionSort128(Record128* a, size_t n) {
+    for (size_t i = 1; i < n; i++) {
+        Record128 item = a[i];
+        size_t j = i;
+        while (j > 0 && a[j - 1].key > item.key) {
+            a[j] = a[j - 1];
+            j--;
+        }
+        a[j] = item;
+    }
+}
+
+static const size_t MSD_SMALL_BUCKET = 32;
+
+// Partitions a[0, n) on digits[level] (high to low), recursing into every bucket.
+// Each level scatters into the other buffer instead of copying back, so the
+// records alternate between arr and its scratch buffer; `inArr` says whether `a`
+// lies in arr, and leaves that end up in the scratch buffer are copied to `other`.
+// `known`, if given, is the histogram of digits[level] over a[0, n).
+static void msdSort128(Record128* a, Record128* other, size_t n, const std::vector<int>& digits, size_t level,
+                       bool inArr, const size_t* known = nullptr) {
+    // A byte that is the same across the bucket needs no scatter
+    size_t count[257];
+    while (n > MSD_SMALL_BUCKET && level < digits.size()) {
+        count[0] = 0;
+        if (known) {
+            std::copy(known, known + 256, count + 1);
+            known = nullptr;
+        } else {
+            std::fill(count + 1, count + 257, 0);
+            for (size_t i = 0; i < n; i++) count[byteOf(a[i].key, digits[level]) + 1]++;
+        }
+        if (*std::max_element(count + 1, count + 257) < n) break;
+        level++;
+    }
+    if (n <= MSD_SMALL_BUCKET || level == digits.size()) {
+        if (n <= MSD_SMALL_BUCKET) insertionSort128(a, n);
+        if (!inArr) std::copy(a, a + n, other);
+        return;
+    }
+
+    int d = digits[level];
+    for (int b = 0; b < 256; b++) count[b + 1] += count[b];
+    size_t start[257];
+    std::copy(count, count + 257, start);
+    for (size_t i = 0; i < n; i++) other[start[byteOf(a[i].key, d)]++] = a[i];
+
+    for (int b = 0; b < 256; b++) {
+        size_t size = count[b + 1] - count[b];
+        if (size > 0) msdSort128(other + count[b], a + count[b], size, digits, level + 1, !inArr);
+    }
+}
+
+void radixSort128(std::vector<Record128>& arr) {
+    size_t n = arr.size();
+    if (n < 2) return;
+
+    // 1. All 16 byte histograms in one pass
+    TraceScope phase("radixSort128", "histogram");
+    std::vector<std::vector<size_t>> count(16, std::vector<size_t>(256, 0));
+    for (const auto& rec : arr) {
+        for (int d = 0; d < 16; d++) count[d][byteOf(rec.key, d)]++;
+    }
+
+    // 2. Bytes whose histogram has a single non-empty bucket never reorder anything
+    std::vector<int> varying;
+    for (int d = 0; d < 16; d++) {
+        bool constant = false;
+        for (int b = 0; b < 256 && !constant; b++) constant = (count[d][b] == n);
+        if (!constant) varying.push_back(d);
+    }
+    if (varying.empty()) return;
+
+    // 3. MSD depth from the histograms: each varying byte, from the top, splits
+    //    the buckets by its number of distinct values (few in the timestamp bytes
+    //    of time-ordered ids) until they reach MSD_SMALL_BUCKET. An MSD level
+    //    (histogram + scatter) measures about 1.5 LSD passes (scatter only), and
+    //    LSD needs one pass per varying byte.
+    size_t msdLevels = 0;
+    double buckets = 1;
+    for (auto d = varying.rbegin(); d != varying.rend() && buckets * MSD_SMALL_BUCKET < n; ++d) {
+        buckets *= 256 - std::count(count[*d].begin(), count[*d].end(), 0);
+        msdLevels++;
+    }
+    std::vector<Record128> buffer(n);
+    if (3 * msdLevels < 2 * varying.size()) {
+        phase.next("scatter");
+        std::vector<int> highFirst(varying.rbegin(), varying.rend());
+        msdSort128(arr.data(), buffer.data(), n, highFirst, 0, true, count[highFirst[0]].data());
+        return;
+    }
+
+    // 4. LSD over the varying bytes; the histograms from step 1 stay valid for every pass
+    phase.next("scatter");
+    std::vector<Record128>* src = &arr;
+    std::vector<Record128>* dst = &buffer;
+    for (int d : varying) {
+        size_t pos = 0;
+        for (int b = 0; b < 256; b++) {
+            size_t c = count[d][b];
+            count[d][b] = pos;
+            pos += c;
+        }
+        for (const auto& rec : *src) (*dst)[count[d][byteOf(rec.key, d)]++] = rec;
+        std::swap(src, dst);
+    }
+
+    phase.next("copy back");
+    if (src != &arr) arr.swap(buffer);
+}
+#endif
+
+// --- 11. Unit-interval Bucket Sort ---
+
+static const size_t UNIT_INSERTION_MAX = 32; // Larger buckets fall back to stable_sort
+
+template <typename R>
+void bucketSortUnit(std::vector<R>& arr) {
+    typedef decltype(R::key) F;
+    size_t n = arr.size();
+    if (n < 2) return;
+    // Signed truncation vectorises on SSE2; 2^30 is exact in float, so the
+    // clamped key below stays inside int32 at every bucket count
+    uint32_t m = n > (1u << 30) ? (1u << 30) : (uint32_t)n;
+
+    // 1. Bucket index per record, in its own loop so it vectorises (multiply,
+    //    clamp, truncate); kept as an oracle for the scatter
+    TraceScope phase("bucketSortUnit", "classify");
+    std::vector<uint32_t> bucketOf(n);
+    const F scale = (F)m, top = (F)(m - 1);
+    for (size_t i = 0; i < n; i++) {
+        F x = arr[i].key * scale;
+        // max(0, x) turns NaN into 0. Past 2^24 buckets float rounds top up to
+        // m, so the index is clamped again after the conversion
+        bucketOf[i] = std::min<uint32_t>((int32_t)std::min(std::max((F)0, x), top), m - 1);
+    }
+
+    phase.next("histogram");
+    std::vector<size_t> start(m + 1, 0);
+    for (size_t i = 0; i < n; i++) start[bucketOf[i] + 1]++;
+
+    phase.next("prefix");
+    for (uint32_t b = 0; b < m; b++) start[b + 1] += start[b];
+
+    // 2. Stable scatter into one flat array
+    phase.next("scatter");
+    std::vector<R> output(n);
+    std::vector<size_t> next(start.begin(), start.end() - 1);
+    for (size_t i = 0; i < n; i++) output[next[bucketOf[i]]++] = arr[i];
+
+    // 3. Buckets hold about one record each when the keys are near-uniform
+    phase.next("bucket sort");
+    auto less = [](const R& a, const R& b) { return a.key < b.key; };
+    for (uint32_t b = 0; b < m; b++) {
+        R* first = output.data() + start[b];
+        size_t count = start[b + 1] - start[b];
+        if (count > UNIT_INSERTION_MAX) {
+            std::stable_sort(first, first + count, less);
+            continue;
+        }
+        for (size_t i = 1; i < count; i++) {
+            R item = first[i];
+            size_t j = i;
+            while (j > 0 && first[j - 1].key > item.key) {
+                first[j] = first[j - 1];
+                j--;
+            }
+            first[j] = item;
+        }
+    }
+
+    arr.swap(output);
+}
+
+// --- 12. Spreadsort ---
+
+static const size_t SPREAD_INSERTION_MAX = 64; // Bins up to this size use insertion sort
+static const size_t SPREAD_MIN_BIN = 256;       // Smaller bins go straight to stable_sort
+static const int SPREAD_MAX_SPLITS = 11;        // At most 2^11 bins per level, so counts stay in L1
+static const int SPREAD_LOG_MEAN_BIN = 2;       // Aim for ~4 records per bin
+static const int SPREAD_LEVEL_COST = 3;         // One radix level costs about 3 comparison levels
+
+template <typename R>
+static void spreadSortRange(R* a, R* tmp, size_t n) {
+    auto less = [](const R& x, const R& y) { return x.key < y.key; };
+    if (n <= SPREAD_INSERTION_MAX) {
+        insertionSortRecords(a, n);
+        return;
+    }
+    if (n < SPREAD_MIN_BIN) {
+        std::stable_sort(a, a + n, less);
+        return;
+    }
+
+    int lo = a[0].key, hi = a[0].key;
+    for (size_t i = 1; i < n; i++) {
+        lo = std::min<int>(lo, a[i].key);
+        hi = std::max<int>(hi, a[i].key);
+    }
+    if (lo == hi) return;
+
+    // Bin count from both the key range and n; the levels still needed to reach
+    // single key values decide whether radix beats a comparison sort at all
+    unsigned span = (unsigned)((long long)hi - lo);
+    int rangeBits = 0, logN = 0;
+    while (rangeBits < 32 && (span >> rangeBits) != 0) rangeBits++;
+    while (((size_t)1 << (logN + 1)) <= n) logN++;
+    int binBits = std::min({SPREAD_MAX_SPLITS, logN - SPREAD_LOG_MEAN_BIN, rangeBits});
+    int levels = (rangeBits + binBits - 1) / binBits;
+    if (levels * SPREAD_LEVEL_COST > logN) {
+        std::stable_sort(a, a + n, less);
+        return;
+    }
+
+    int shift = rangeBits - binBits;
+    Classifier classifier = shiftClassifier(lo, hi, shift);
+    size_t bins = classifier.buckets;
+
+    std::vector<size_t> count(bins + 1, 0);
+    size_t* binEnd = count.data() + 1;
+    forEachBucket(classifier, a, n, [binEnd](size_t, uint32_t b) { binEnd[b]++; });
+    for (size_t b = 0; b < bins; b++) count[b + 1] += count[b];
+
+    std::vector<size_t> next(count.begin(), count.end() - 1);
+    size_t* slot = next.data();
+    forEachBucket(classifier, a, n, [a, tmp, slot](size_t i, uint32_t b) { tmp[slot[b]++] = a[i]; });
+    std::copy(tmp, tmp + n, a);
+
+    if (shift == 0) return; // Every bin holds a single key value
+    for (size_t b = 0; b < bins; b++) {
+        size_t size = count[b + 1] - count[b];
+        if (size > 1) spreadSortRange(a + count[b], tmp + count[b], size);
+    }
+}
+
+template <typename R>
+void spreadSort(std::vector<R>& arr) {
+    if (arr.size() < 2) return;
+    TraceScope phase("spreadSort", "sort");
+    std::vector<R> buffer(arr.size());
+    spreadSortRange(arr.data(), buffer.data(), arr.size());
+}
+
+// --- 13. Hybrid MSD/LSD Radix Sort ---
+
+static const size_t HYBRID_DEFAULT_CACHE = 1 << 20;
+static const int HYBRID_MAX_MSD_BITS = 12; // 4096 partitions keep the MSD scatter TLB-friendly
+
+// Base-256 LSD over the low `bits` of (key - minVal) for one partition, from
+// src into dst (both n records). All digit histograms come from one read.
+template <typename R>
+static void lsdPartition(R* src, R* dst, size_t n, int minVal, int bits) {
+    int passes = (bits + 7) / 8;
+    size_t count[4][256] = {{0}};
+    for (size_t i = 0; i < n; i++) {
+        unsigned offset = (unsigned)((long long)src[i].key - minVal);
+        for (int p = 0; p < passes; p++) count[p][(offset >> (8 * p)) & 0xFF]++;
+    }
+
+    R* from = src;
+    R* to = dst;
+    for (int p = 0; p < passes; p++) {
+        int shift = 8 * p;
+        if (count[p][(((unsigned)((long long)from[0].key - minVal)) >> shift) & 0xFF] == n) continue; // Constant digit
+        size_t pos = 0;
+        for (int b = 0; b < 256; b++) {
+            size_t c = count[p][b];
+            count[p][b] = pos;
+            pos += c;
+        }
+        for (size_t i = 0; i < n; i++) {
+            const R& r = from[i];
+            to[count[p][((unsigned)((long long)r.key - minVal) >> shift) & 0xFF]++] = r;
+        }
+        std::swap(from, to);
+    }
+    if (from != dst) std::copy(from, from + n, dst);
+}
+
+template <typename R>
+void radixSortHybrid(std::vector<R>& arr, int threads, size_t cacheBytes) {
+    if (arr.size() < 2) return;
+    size_t n = arr.size();
+    threads = std::max(1, (int)std::min<size_t>(std::max(1, threads), n));
+    if (cacheBytes == 0) cacheBytes = HYBRID_DEFAULT_CACHE;
+
+    int minVal, maxVal;
+    getMinMaxParallel(arr, threads, minVal, maxVal);
+    unsigned span = (unsigned)((long long)maxVal - minVal);
+    if (span == 0) return;
+    int totalBits = 0;
+    while (totalBits < 32 && (span >> totalBits) != 0) totalBits++;
+
+    // Enough MSD bits that an average partition plus its buffer fits the cache.
+    // A key range of one digit is a single LSD pass, which no partitioning beats.
+    size_t partitionRecords = std::max<size_t>(1, cacheBytes / (2 * sizeof(R)));
+    int msdBits = 0;
+    while (totalBits > 8 && msdBits < HYBRID_MAX_MSD_BITS && msdBits < totalBits &&
+           (n >> msdBits) > partitionRecords)
+        msdBits++;
+    // Then round the low bits down to whole bytes: smaller partitions, same LSD pass count
+    if (msdBits > 0 && totalBits - (totalBits - msdBits) / 8 * 8 <= HYBRID_MAX_MSD_BITS)
+        msdBits = totalBits - (totalBits - msdBits) / 8 * 8;
+    std::vector<R> buffer(n);
+    if (msdBits == 0) {
+        TraceScope phase("radixSortHybrid", "lsd");
+        lsdPartition(arr.data(), buffer.data(), n, minVal, totalBits);
+        arr.swap(buffer);
+        return;
+    }
+    int shift = totalBits - msdBits;
+    Classifier classifier = shiftClassifier(minVal, maxVal, shift);
+    size_t bins = classifier.buckets;
+
+    // 1. MSD pass: per-thread histograms over the classified bins, exclusive
+    //    prefix over (bin, thread), stable scatter
+    std::vector<std::vector<size_t>> count(threads, std::vector<size_t>(bins, 0));
+    runOnThreads(threads, [&](int t) {
+        TraceScope phase("radixSortHybrid", "msd histogram");
+        size_t begin = chunkBegin(n, threads, t), end = chunkBegin(n, threads, t + 1);
+        std::vector<size_t>& histogram = count[t];
+        forEachBucket(classifier, arr.data() + begin, end - begin, [&](size_t, uint32_t b) { histogram[b]++; });
+    });
+    std::vector<size_t> binStart(bins + 1, 0);
+    size_t pos = 0;
+    for (size_t b = 0; b < bins; b++) {
+        binStart[b] = pos;
+        for (int t = 0; t < threads; t++) {
+            size_t c = count[t][b];
+            count[t][b] = pos;
+            pos += c;
+        }
+    }
+    binStart[bins] = n;
+    runOnThreads(threads, [&](int t) {
+        TraceScope phase("radixSortHybrid", "msd scatter");
+        size_t begin = chunkBegin(n, threads, t), end = chunkBegin(n, threads, t + 1);
+        std::vector<size_t>& offset = count[t];
+        const R* src = arr.data() + begin;
+        forEachBucket(classifier, src, end - begin, [&](size_t i, uint32_t b) { buffer[offset[b]++] = src[i]; });
+    });
+
+    // 2. LSD inside each partition; sizes vary, so workers take the next one as they finish
+    std::atomic<size_t> nextBin(0);
+    runOnThreads(threads, [&](int t) {
+        (void)t;
+        TraceScope phase("radixSortHybrid", "lsd");
+        for (size_t b = nextBin++; b < bins; b = nextBin++) {
+            size_t begin = binStart[b], size = binStart[b + 1] - begin;
+            if (size > 1) lsdPartition(buffer.data() + begin, arr.data() + begin, size, minVal, shift);
+            else if (size == 1) arr[begin] = buffer[begin];
+        }
+    });
+}
+
+// --- Explicit instantiations for every supported record width ---
+#define INSTANTIATE_RECORD_SORTS(R) \
+    template void countingSortStable<R>(std::vector<R>&, SortOrder); \
+    template void countingSortUnstable<R>(std::vector<R>&); \
+    template void radixSortLSD<R>(std::vector<R>&, SortOrder); \
+    template void bucketSort<R>(std::vector<R>&); \
+    template void pigeonholeSort<R>(std::vector<R>&); \
+    template void sortByKeyIndex<R>(std::vector<R>&, void (*)(std::vector<Record>&)); \
+    template void countingSortIndirect<R>(std::vector<R>&); \
+    template void countingSortParallel<R>(std::vector<R>&, int); \
+    template void radixSortParallel<R>(std::vector<R>&, int); \
+    template uint64_t multisetHash<R>(const std::vector<R>&, int); \
+    template SortCheck verifySort<R>(const std::vector<R>&, uint64_t, int, SortOrder); \
+    template KeyProfile profileKeys<R>(const std::vector<R>&, int); \
+    template SortKernel sortAuto<R>(std::vector<R>&, int); \
+    template void spreadSort<R>(std::vector<R>&); \
+    template void radixSortHybrid<R>(std::vector<R>&, int, size_t); \
+    template void classify<R>(const Classifier&, const R*, size_t, uint32_t*);
+
+INSTANTIATE_RECORD_SORTS(Record)
+INSTANTIATE_RECORD_SORTS(PaddedRecord<16>)
+INSTANTIATE_RECORD_SORTS(PaddedRecord<32>)
+INSTANTIATE_RECORD_SORTS(PaddedRecord<64>)
+INSTANTIATE_RECORD_SORTS(PaddedRecord<128>)
+INSTANTIATE_RECORD_SORTS(PaddedRecord<256>)
+INSTANTIATE_RECORD_SORTS(Record8)
+INSTANTIATE_RECORD_SORTS(Record16)
+
+// Floating-point keys
+template void bucketSortUnit<FloatRecord>(std::vector<FloatRecord>&);
+template void bucketSortUnit<DoubleRecord>(std::vector<DoubleRecord>&);
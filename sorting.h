@@ -4,6 +4,8 @@
 #include <vector>
 #include <algorithm>
 #include <iostream>
+#include <cstdint>
+#include <string>
 
 // The data structure used for stability testing
 struct Record {
@@ -16,19 +18,256 @@ struct Record {
     }
 };
 
+// A wider record for payload-size experiments: same int key / int id header as
+// Record, followed by an opaque payload so that sizeof == Bytes.
+template <int Bytes>
+struct PaddedRecord {
+    static_assert(Bytes > 2 * (int)sizeof(int), "use Record for the 8-byte case");
+
+    int key;
+    int id;
+    char payload[Bytes - 2 * sizeof(int)];
+};
+
+// A record with a narrow key type (priorities, ports, small codes). For 8- and
+// 16-bit keys countingSortStable and radixSortLSD switch automatically to a
+// counting sort over fixed 256-entry tables: one pass for 8-bit keys, two byte
+// passes for 16-bit keys (countingSortStable only up to 2^19 records). Float
+// and double keys (normalized scores) go to bucketSortUnit.
+template <typename Key>
+struct KeyedRecord {
+    Key key;
+    int id;
+};
+
+using Record8 = KeyedRecord<uint8_t>;
+using Record16 = KeyedRecord<uint16_t>;
+using FloatRecord = KeyedRecord<float>;
+using DoubleRecord = KeyedRecord<double>;
+
+// All sorts are templates over the record type R, which must expose an integral
+// `key` and an int `id`. They are explicitly instantiated in sorting.cpp for
+// Record, PaddedRecord<16, 32, 64, 128, 256>, Record8 and Record16.
+
+// Output order for the kernels that take one. Descending runs the prefix sums
+// from the top instead of reversing afterwards, so it costs the same as
+// ascending and stays stable (equal keys keep input order).
+enum class SortOrder { Ascending, Descending };
+
 // 1. Counting Sort (Stable) - As described in Algorithm 1
-void countingSortStable(std::vector<Record>& arr);
+template <typename R>
+void countingSortStable(std::vector<R>& arr, SortOrder order);
+
+template <typename R>
+void countingSortStable(std::vector<R>& arr) {
+    countingSortStable(arr, SortOrder::Ascending);
+}
 
 // 2. Counting Sort (Non-Stable) - As described in Section 3.1.2
-void countingSortUnstable(std::vector<Record>& arr);
+template <typename R>
+void countingSortUnstable(std::vector<R>& arr);
 
 // 3. LSD Radix Sort - As described in Algorithm 2
-void radixSortLSD(std::vector<Record>& arr);
+template <typename R>
+void radixSortLSD(std::vector<R>& arr, SortOrder order);
+
+template <typename R>
+void radixSortLSD(std::vector<R>& arr) {
+    radixSortLSD(arr, SortOrder::Ascending);
+}
 
 // 4. Bucket Sort - As described in Algorithm 3
-void bucketSort(std::vector<Record>& arr);
+template <typename R>
+void bucketSort(std::vector<R>& arr);
 
 // 5. Pigeonhole Sort - As described in Algorithm 4
-void pigeonholeSort(std::vector<Record>& arr);
+template <typename R>
+void pigeonholeSort(std::vector<R>& arr);
+
+// 6. Key-Index Sort - Sorts compact {key, index} Records with `keySort` (any stable
+// Record sort above), then gathers the wide records once in the final order.
+template <typename R>
+void sortByKeyIndex(std::vector<R>& arr, void (*keySort)(std::vector<Record>&));
+
+// 7. Indirect Counting Sort - Scatters pointers to the records instead of the
+// records themselves, then gathers once. Stable.
+template <typename R>
+void countingSortIndirect(std::vector<R>& arr);
+
+// --- Parallel kernels ---
+// Both split the input into one contiguous chunk per thread, build per-thread
+// histograms, and scatter chunk by chunk, so the result is stable like the
+// single-threaded versions. `threads` <= 1 runs on the calling thread.
+
+// 8. Parallel Counting Sort (Stable)
+template <typename R>
+void countingSortParallel(std::vector<R>& arr, int threads);
+
+// 9. Parallel LSD Radix Sort (Stable, base 256)
+template <typename R>
+void radixSortParallel(std::vector<R>& arr, int threads);
+
+// --- Floating-point keys ---
+
+// 11. Unit-interval Bucket Sort (Stable) - For float / double keys in [0, 1),
+// e.g. calibrated scores. Bucket i of n holds [i/n, (i+1)/n): the indices come
+// from floor(key * n) in one vectorisable pass, records are scattered into one
+// flat array by counting, and each bucket is finished by insertion sort.
+// Keys outside [0, 1) are clamped to the end buckets, so they are still sorted,
+// only more slowly. NaN keys go to the first bucket, where their order is
+// unspecified. Instantiated for FloatRecord and DoubleRecord.
+template <typename R>
+void bucketSortUnit(std::vector<R>& arr);
+
+// --- Hybrid radix / comparison ---
+
+// 12. Spreadsort (Stable) - MSD radix for key ranges much wider than n. Each
+// level splits on the top bits of (key - min) into up to 2^11 bins, about four
+// records per bin, then recurses with each bin's own min / max. Bins under 256
+// records, or bins whose range would still need too many levels compared with
+// log2(n), are finished by insertion sort (up to 64) or std::stable_sort.
+template <typename R>
+void spreadSort(std::vector<R>& arr);
+
+// 13. Hybrid MSD/LSD Radix Sort (Stable) - One MSD pass on the top bits of
+// (key - min) splits the input into partitions that fit, with their buffer, in
+// `cacheBytes` (0 = 1 MiB, a typical L2). Each partition then runs its base-256
+// LSD passes while cache-resident, so only the MSD pass streams through DRAM.
+// Partitions are independent and are shared out to `threads` workers.
+template <typename R>
+void radixSortHybrid(std::vector<R>& arr, int threads = 1, size_t cacheBytes = 0);
+
+#ifdef __SIZEOF_INT128__
+// --- 128-bit keys (UUIDs, (hi, lo) composite ids) ---
+
+typedef unsigned __int128 Key128;
+
+inline Key128 makeKey128(uint64_t hi, uint64_t lo) {
+    return ((Key128)hi << 64) | lo;
+}
+
+struct Record128 {
+    Key128 key;
+    int id;
+};
+
+// 10. 128-bit Radix Sort (Stable, base 256)
+// One counting pass builds all 16 byte histograms; bytes that are constant across
+// the input (common in time-ordered UUIDs) are skipped. The histograms also give
+// the MSD depth: each high byte splits the buckets by its number of distinct
+// values. When that depth is cheaper than one LSD pass per varying byte, it
+// partitions MSD-first on the high bytes, alternating between the array and one
+// buffer, and finishes small buckets with insertion sort; otherwise it runs LSD
+// passes over the varying bytes only.
+void radixSort128(std::vector<Record128>& arr);
+#endif
+
+// --- Classification ---
+// Shared first step of the distribution sorts: map every key to a bucket id and
+// write the ids to an oracle array that the histogram and scatter passes read,
+// so no pass recomputes them. Batches of 8 (AVX2) or 16 (AVX-512) keys per
+// instruction when the build enables them (e.g. -march=native), scalar otherwise.
+// Every mapping is monotone, so bucket order follows key order.
+struct Classifier {
+    enum Mode { LINEAR, SHIFT, SPLITTERS };
+
+    Mode mode;
+    int minKey;
+    uint32_t buckets;
+    uint32_t scale;        // LINEAR: bucket = (key - minKey) * scale >> 32
+    int shift;             // SHIFT: bucket = (key - minKey) >> shift
+    int levels;            // SPLITTERS: tree depth, buckets = 2^levels
+    std::vector<int> tree; // SPLITTERS: splitters in breadth-first order, tree[0] unused
+};
+
+// `buckets` equal-width buckets over [minKey, maxKey]; when that is at least one
+// bucket per key it becomes SHIFT with shift 0 and buckets = maxKey - minKey + 1.
+Classifier linearClassifier(int minKey, int maxKey, uint32_t buckets);
+
+// Buckets of 2^shift keys over [minKey, maxKey] (radix-style top bits)
+Classifier shiftClassifier(int minKey, int maxKey, int shift);
+
+// Bucket i holds keys in (s[i-1], s[i]] for sorted splitters s, and bucket
+// s.size() the keys above s.back(). The tree is padded with INT_MAX to
+// 2^levels - 1 splitters, so the buckets after s.size() stay empty.
+Classifier splitterClassifier(const std::vector<int>& sortedSplitters);
+
+// out[i] = bucket of keys[i]
+void classifyKeys(const Classifier& c, const int* keys, size_t n, uint32_t* out);
+
+// out[i] = bucket of recs[i].key
+template <typename R>
+void classify(const Classifier& c, const R* recs, size_t n, uint32_t* out);
+
+// Instruction set the classification kernel was built for: "AVX-512", "AVX2" or "scalar"
+const char* classifyIsa();
+
+// --- Verification ---
+
+struct SortCheck {
+    bool sorted;      // Keys are non-decreasing
+    bool stable;      // Equal keys keep increasing ids
+    bool permutation; // The (key, id) multiset equals the input's (by hash)
+};
+
+// Order-independent 64-bit hash of the (key, id) multiset: the wrapping sum of a
+// strong mix of every pair, so any reordering hashes the same and any lost,
+// duplicated or rewritten record changes it with probability ~1 - 2^-64.
+template <typename R>
+uint64_t multisetHash(const std::vector<R>& arr, int threads = 1);
+
+// Checks order, stability and the multiset hash against `inputHash` (taken with
+// multisetHash before sorting) in a single parallel, branch-free pass.
+template <typename R>
+SortCheck verifySort(const std::vector<R>& arr, uint64_t inputHash, int threads = 1,
+                     SortOrder order = SortOrder::Ascending);
+
+// --- Key statistics ---
+// One parallel pass over the keys (sampling 4096 of them on the way) that
+// gathers what a dispatcher or planner needs beyond min and max. Every kernel
+// can then be chosen (and sized) from it.
+struct KeyProfile {
+    static constexpr int BINS = 64;
+
+    size_t n;
+    int minKey, maxKey;            // Exact
+    double distinct;               // Estimated from the sample, exact up to 4096 records
+    size_t descents;               // Positions i where key[i] < key[i - 1], exact
+    size_t longestRun;             // Longest non-decreasing run, exact
+    std::vector<size_t> histogram; // BINS equal-width bins over [minKey, maxKey], scaled up from the sample
+};
+
+template <typename R>
+KeyProfile profileKeys(const std::vector<R>& arr, int threads = 1);
+
+enum class SortKernel { AlreadySorted, Reverse, Counting, Radix, StableSort };
+
+const char* sortKernelName(SortKernel kernel);
+
+// Sorted input needs nothing and strictly descending input only a reversal; a key
+// range within a few times n goes to counting sort, small inputs to
+// std::stable_sort, and everything else to base-256 radix sort.
+SortKernel chooseSortKernel(const KeyProfile& profile);
+
+// Profiles `arr`, then sorts it (stably) with the kernel chooseSortKernel picks.
+// Returns that kernel.
+template <typename R>
+SortKernel sortAuto(std::vector<R>& arr, int threads = 1);
+
+// --- Phase tracing ---
+// While enabled, every kernel records one event per phase (getMinMax, histogram,
+// prefix, scatter, bucket sort, copy back) on the thread that ran it. The events
+// can be written as Chrome trace JSON and opened in chrome://tracing or Perfetto.
+void setSortTracing(bool enabled);
+void clearSortTrace();
+bool writeSortTrace(const std::string& path);
+
+// Pin worker t of every parallel kernel to CPU (t mod hardware threads). Off by default.
+void setThreadPinning(bool enabled);
+
+// Scatter runs of consecutive records bound for the same bucket as one block copy
+// in countingSortStable and radixSortLSD, when the mean run length is at least 2.
+// On by default; off restores the per-record scatter for comparison.
+void setRunScatter(bool enabled);
 
 #endif // SORTING_H
\ No newline at end of file